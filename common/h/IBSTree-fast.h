@@ -41,12 +41,33 @@
 #include <boost/mpl/inherit_linearly.hpp>
 #include <boost/mpl/inherit.hpp>
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <set>
+#include <vector>
 #include <iostream>
 
 namespace Dyninst
 {
 
+    /*
+     * Point lookups (find(X) and successor(X)) are served from an immutable,
+     * sorted snapshot of the tree when one is current, without taking the
+     * reader-writer lock.  Writers only bump a version number; once a
+     * thread has made enough lookups through the locked path, it rebuilds
+     * the snapshot and publishes it with a single pointer store.  This
+     * batches the cost of a rebuild over many writes, and a read-mostly
+     * tree answers nearly all lookups from the snapshot.  Readers of the
+     * snapshot only write thread-local state.
+     *
+     * Superseded snapshots are retired rather than freed, since a reader
+     * may still be using one, and reclaimed through dyn_epoch once no
+     * reader can hold them.  If readers keep the epoch from advancing and
+     * retired snapshots grow to several times the size of the tree,
+     * rebuilding pauses (lookups take the locked path) until a later
+     * rebuild attempt can reclaim them.
+     */
     template <typename ITYPE >
     class IBSTree_fast {
     private:
@@ -56,6 +77,40 @@ namespace Dyninst
     public:
         typedef typename ITYPE::type interval_type;
 
+    private:
+        struct snapshot {
+            unsigned long version;
+            // unique_intervals, ordered by high()
+            std::vector<ITYPE*> unique;
+            // overlapping_intervals, ordered by low(), and the largest
+            // high() among each entry and all entries before it
+            std::vector<ITYPE*> overlapping;
+            std::vector<interval_type> max_high;
+        };
+
+        // Everything in overlapping_intervals, which cannot be enumerated
+        std::set<ITYPE*> overlapping_entries;
+
+        mutable std::atomic<unsigned long> version;
+        mutable std::atomic<snapshot*> current;
+        // Locked lookups a thread makes before rebuilding; grows with the tree
+        mutable std::atomic<unsigned long> rebuild_after;
+        mutable std::mutex snapshot_lock;
+        // Snapshots and the epoch they were retired in; guarded by snapshot_lock
+        mutable std::vector<std::pair<unsigned long, snapshot*> > retired;
+        mutable unsigned long retired_entries;
+
+        void modified() {
+            version.fetch_add(1, std::memory_order_release);
+        }
+        snapshot* current_snapshot() const;
+        void rebuild_snapshot() const;
+        void reclaim_snapshots() const;
+        static void find(snapshot const*, interval_type, std::set<ITYPE*> &);
+        static ITYPE* successor(snapshot const*, interval_type);
+
+    public:
+
         IBSTree<ITYPE> overlapping_intervals;
         typedef boost::multi_index_container<ITYPE*,
                 boost::multi_index::indexed_by<
@@ -66,12 +121,19 @@ namespace Dyninst
         //typedef std::set<ITYPE*, order_by_lower<ITYPE> > interval_set;
         interval_set unique_intervals;
 
-        IBSTree_fast()
+        IBSTree_fast() :
+            version(0),
+            current(NULL),
+            rebuild_after(16),
+            retired_entries(0)
         {
         }
         ~IBSTree_fast()
         {
             //std::cerr << "Fast interval tree had " << unique_intervals.size() << " unique intervals and " << overlapping_intervals.size() << " overlapping" << std::endl;
+            delete current.load();
+            for (unsigned i = 0; i < retired.size(); ++i)
+                delete retired[i].second;
         }
         int size() const
         {
@@ -107,10 +169,12 @@ namespace Dyninst
         dyn_rwlock::unique_lock l(rwlock);
 
         // find in overlapping first
+        modified();
         std::set<ITYPE*> dummy;
         if(overlapping_intervals.find(entry, dummy))
         {
             overlapping_intervals.insert(entry);
+            overlapping_entries.insert(entry);
         } else { 
 	  typename interval_set::iterator lower =
 	    unique_intervals.upper_bound(entry->low());
@@ -121,12 +185,14 @@ namespace Dyninst
 		(*upper)->low() <= entry->high())
 	    {
 	      overlapping_intervals.insert(*upper);
+	      overlapping_entries.insert(*upper);
 	      ++upper;
 	    }
 	  if(upper != lower)
 	    {
 	      unique_intervals.erase(lower, upper);
 	      overlapping_intervals.insert(entry);
+	      overlapping_entries.insert(entry);
 	    }
 	  else
 	    {
@@ -139,15 +205,143 @@ namespace Dyninst
     {
         dyn_rwlock::unique_lock l(rwlock);
 
+        modified();
         overlapping_intervals.remove(entry);
+        overlapping_entries.erase(entry);
         typename interval_set::iterator found = unique_intervals.find(entry->high());
         if(found != unique_intervals.end() && *found == entry) unique_intervals.erase(found);
     }
     template<class ITYPE>
+    typename IBSTree_fast<ITYPE>::snapshot* IBSTree_fast<ITYPE>::current_snapshot() const
+    {
+        snapshot *s = current.load(std::memory_order_acquire);
+        if(s && s->version == version.load(std::memory_order_acquire)) return s;
+
+        // Rebuild once this thread's locked lookups have paid for it; the
+        // count is per thread so the read path writes no shared state.
+        static thread_local unsigned long stale_lookups = 0;
+        if(++stale_lookups >= rebuild_after.load(std::memory_order_relaxed))
+        {
+            stale_lookups = 0;
+            rebuild_snapshot();
+        }
+        return NULL;
+    }
+    template<class ITYPE>
+    void IBSTree_fast<ITYPE>::rebuild_snapshot() const
+    {
+        std::unique_lock<std::mutex> sl(snapshot_lock, std::try_to_lock);
+        if(!sl.owns_lock()) return; // someone else is rebuilding
+
+        reclaim_snapshots();
+        snapshot *s = new snapshot;
+        {
+            dyn_rwlock::shared_lock l(rwlock);
+            s->version = version.load(std::memory_order_acquire);
+            snapshot *old = current.load(std::memory_order_acquire);
+            if((old && old->version == s->version) ||
+               retired_entries > 4 * (unique_intervals.size() + overlapping_entries.size()) + 4096)
+            {
+                delete s;
+                return;
+            }
+            s->unique.assign(unique_intervals.begin(), unique_intervals.end());
+            s->overlapping.assign(overlapping_entries.begin(), overlapping_entries.end());
+        }
+        std::sort(s->overlapping.begin(), s->overlapping.end(),
+                  [](ITYPE *a, ITYPE *b) { return a->low() < b->low(); });
+        s->max_high.reserve(s->overlapping.size());
+        for(unsigned i = 0; i < s->overlapping.size(); ++i)
+        {
+            interval_type h = s->overlapping[i]->high();
+            if(i && s->max_high[i-1] > h) h = s->max_high[i-1];
+            s->max_high.push_back(h);
+        }
+
+        rebuild_after.store(16 + s->unique.size() + s->overlapping.size(),
+                            std::memory_order_relaxed);
+        snapshot *old = current.exchange(s, std::memory_order_acq_rel);
+        if(old)
+        {
+            retired.push_back(std::make_pair(dyn_epoch::current(), old));
+            retired_entries += old->unique.size() + old->overlapping.size();
+        }
+        reclaim_snapshots();
+    }
+    template<class ITYPE>
+    void IBSTree_fast<ITYPE>::reclaim_snapshots() const
+    {
+        // Called with snapshot_lock held
+        if(retired.empty()) return;
+        unsigned long held = dyn_epoch::collect();
+        unsigned kept = 0;
+        for(unsigned i = 0; i < retired.size(); ++i)
+        {
+            snapshot *s = retired[i].second;
+            if(retired[i].first >= held)
+            {
+                retired[kept++] = retired[i];
+                continue;
+            }
+            retired_entries -= s->unique.size() + s->overlapping.size();
+            delete s;
+        }
+        retired.resize(kept);
+    }
+    template<class ITYPE>
+    void IBSTree_fast<ITYPE>::find(snapshot const* s, interval_type X, std::set<ITYPE*> &results)
+    {
+        // Overlapping entries are ordered by low(); walk back from the last
+        // one starting at or before X until none before can reach X.
+        typename std::vector<ITYPE*>::const_iterator it =
+            std::upper_bound(s->overlapping.begin(), s->overlapping.end(), X,
+                             [](interval_type x, ITYPE *e) { return x < e->low(); });
+        bool found_overlapping = false;
+        for(size_t i = it - s->overlapping.begin(); i > 0 && s->max_high[i-1] > X; --i)
+        {
+            if(s->overlapping[i-1]->high() > X)
+            {
+                results.insert(s->overlapping[i-1]);
+                found_overlapping = true;
+            }
+        }
+        if(found_overlapping) return;
+
+        typename std::vector<ITYPE*>::const_iterator u =
+            std::upper_bound(s->unique.begin(), s->unique.end(), X,
+                             [](interval_type x, ITYPE *e) { return x < e->high(); });
+        if(u != s->unique.end() && (*u)->low() <= X) results.insert(*u);
+    }
+    template<class ITYPE>
+    ITYPE* IBSTree_fast<ITYPE>::successor(snapshot const* s, interval_type X)
+    {
+        typename std::vector<ITYPE*>::const_iterator o =
+            std::upper_bound(s->overlapping.begin(), s->overlapping.end(), X,
+                             [](interval_type x, ITYPE *e) { return x < e->low(); });
+        typename std::vector<ITYPE*>::const_iterator u =
+            std::upper_bound(s->unique.begin(), s->unique.end(), X,
+                             [](interval_type x, ITYPE *e) { return x < e->high(); });
+        ITYPE *overlapping_ub = (o != s->overlapping.end()) ? *o : NULL;
+        ITYPE *unique_ub = (u != s->unique.end()) ? *u : NULL;
+        if(overlapping_ub && unique_ub)
+            return overlapping_ub->low() < unique_ub->low() ? overlapping_ub : unique_ub;
+        return overlapping_ub ? overlapping_ub : unique_ub;
+    }
+    template<class ITYPE>
     int IBSTree_fast<ITYPE>::find(interval_type X, std::set<ITYPE*> &results) const
     {
-      dyn_rwlock::shared_lock l(rwlock);
       int num_old_results = results.size();
+      {
+        dyn_epoch::guard g;
+        snapshot *s = current_snapshot();
+        if(s)
+        {
+          find(s, X, results);
+          return results.size() - num_old_results;
+        }
+      }
+
+      dyn_rwlock::shared_lock l(rwlock);
 
       int num_overlapping = overlapping_intervals.find(X, results);
       if(num_overlapping > 0) return num_overlapping;
@@ -200,6 +394,12 @@ namespace Dyninst
     template <typename ITYPE>
     ITYPE* IBSTree_fast<ITYPE>::successor(interval_type X) const
     {
+        {
+            dyn_epoch::guard g;
+            snapshot *s = current_snapshot();
+            if(s) return successor(s, X);
+        }
+
         std::set<ITYPE*> tmp;
         successor(X, tmp);
         assert(tmp.size() <= 1);
@@ -210,7 +410,9 @@ namespace Dyninst
     void IBSTree_fast<ITYPE>::clear()
     {
         dyn_rwlock::unique_lock l(rwlock);
+        modified();
         overlapping_intervals.clear();
+        overlapping_entries.clear();
         unique_intervals.clear();
     }
 
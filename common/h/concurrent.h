@@ -245,6 +245,27 @@ public:
     static thread_local dyn_thread me;
 };
 
+// Epoch-based reclamation for lock-free readers.  A reader holds a
+// dyn_epoch::guard while it uses shared data; entering and leaving only
+// write to a slot owned by the calling thread.  Data unlinked while
+// current() returned e may be freed once collect() returns a value above e.
+class COMMON_EXPORT dyn_epoch {
+public:
+    class COMMON_EXPORT guard {
+    public:
+        guard();
+        ~guard();
+        guard(const guard&) = delete;
+        guard& operator=(const guard&) = delete;
+    };
+
+    // The epoch to tag unlinked data with
+    static unsigned long current();
+    // Advances the epoch if every reader has seen the current one, and
+    // returns the oldest epoch whose data a reader may still hold
+    static unsigned long collect();
+};
+
 template<typename T>
 class dyn_threadlocal {
     std::vector<T> cache;
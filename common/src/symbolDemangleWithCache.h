@@ -28,6 +28,11 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#ifndef SYMBOL_DEMANGLE_WITH_CACHE_H
+#define SYMBOL_DEMANGLE_WITH_CACHE_H
+
 #include <string>
 
-std::string const& symbol_demangle_with_cache(const std::string &symName, bool includeParams);
+std::string symbol_demangle_with_cache(const std::string &symName, bool includeParams);
+
+#endif
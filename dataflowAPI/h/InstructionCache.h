@@ -33,7 +33,12 @@
 
 #include "dyntypes.h"
 #include "bitArray.h"
-#include <map>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "CFG.h"
 
 using namespace Dyninst;
@@ -46,18 +51,69 @@ struct ReadWriteInfo
   int insnSize;
 };
 
-
+/*
+ * Registers read and written by each instruction, shared by every liveness
+ * query against a CodeObject.  Entries are keyed by the instruction address,
+ * the block containing it (the call and exit effects depend on the block),
+ * and the address width of the analysis.
+ *
+ * The table is a set-associative hash table of a fixed number of entries,
+ * chosen when the cache is created (see setDefaultCapacity), and older
+ * entries are replaced as it fills.  The register sets are stored inline,
+ * so the table does no allocation after it is created.  Buckets are
+ * protected by a striped set of locks.  Any change to the CodeObject's CFG
+ * invalidates the whole table.
+ */
 class InstructionCache
 {
-  std::map<Address, ReadWriteInfo> cache;
-  ParseAPI::Function* currentFunction;
+  typedef unsigned long word_t;
+  static const unsigned max_regs = 256;
+  static const unsigned word_bits = sizeof(word_t) * CHAR_BIT;
+  static const unsigned num_words = max_regs / word_bits;
+
+  struct Entry
+  {
+    Address addr;
+    ParseAPI::Block *block;
+    int width;
+    unsigned generation;
+    int insnSize;
+    unsigned nregs;
+    word_t read[num_words];
+    word_t written[num_words];
+  };
+
+  static const unsigned entries_per_bucket = 4;
+  static const unsigned num_locks = 256;
+
+  unsigned num_buckets;
+  std::vector<Entry> table;
+  std::mutex locks[num_locks];
+  std::vector<unsigned char> next_victim;
+  // Entries are valid only if they carry the current generation
+  std::atomic<unsigned> generation;
+
+  unsigned bucketOf(Address addr, ParseAPI::Block *block) const;
 
   public:
-  InstructionCache(): currentFunction(NULL) {}
-  bool getLivenessInfo(Address addr, ParseAPI::Function* func, ReadWriteInfo& rw);
-  void insertInstructionInfo(Address addr, ReadWriteInfo rw, ParseAPI::Function* func);
-  void clean() {cache.clear();}
-  ParseAPI::Function* getCurFunc() {return currentFunction;}
+  // Holds about 'capacity' instructions, rounded to a power of two
+  explicit InstructionCache(std::size_t capacity);
+  bool getLivenessInfo(Address addr, ParseAPI::Block *block, int width, ReadWriteInfo& rw);
+  // Read the generation before computing rw; the entry is dropped if the
+  // cache was cleaned in the meantime.
+  unsigned currentGeneration() const { return generation.load(); }
+  void insertInstructionInfo(Address addr, ParseAPI::Block *block, int width,
+                             const ReadWriteInfo &rw, unsigned gen);
+  void clean() {generation++;}
+
+  // The cache for a CodeObject, created on first use.  The CodeObject owns
+  // it; the returned pointer expires when the CodeObject is destroyed.
+  static std::weak_ptr<InstructionCache> get(ParseAPI::CodeObject *obj);
+
+  // Number of instructions held by caches created from now on.  The
+  // default is 32768, or DYNINST_INSN_CACHE_ENTRIES if that is set.
+  static void setDefaultCapacity(std::size_t capacity);
+  static std::size_t defaultCapacity();
 };
 
 #endif //!defined(INSTRUCTION_CACHE_H)
@@ -40,6 +40,7 @@
 #include "bitArray.h"
 #include "ABI.h"
 #include <map>
+#include <memory>
 #include <set>
 #include "Register.h"
 
@@ -55,14 +56,15 @@ class DATAFLOW_EXPORT LivenessAnalyzer{
 	std::map<ParseAPI::Block*, livenessData> blockLiveInfo;
 	std::map<ParseAPI::Function*, bool> liveFuncCalculated;
         std::map<ParseAPI::Function*, bitArray> funcRegsDefined;
-	InstructionCache cachedLivenessInfo;
 
 	const bitArray& getLivenessIn(ParseAPI::Block *block);
 	const bitArray& getLivenessOut(ParseAPI::Block *block, bitArray &allRegsDefined);
+	const bitArray& getLivenessOut(const ParseAPI::CFGSnapshot &snap, unsigned id, bitArray &allRegsDefined);
 	void processEdgeLiveness(ParseAPI::Edge* e, livenessData& data, ParseAPI::Block* block, const bitArray& allRegsDefined);
 	
-	void summarizeBlockLivenessInfo(ParseAPI::Function* func, ParseAPI::Block *block, bitArray &allRegsDefined);
-	bool updateBlockLivenessInfo(ParseAPI::Block *block, bitArray &allRegsDefined);
+	void summarizeBlockLivenessInfo(ParseAPI::Block *block, bitArray &allRegsDefined);
+	bool updateBlockLivenessInfo(ParseAPI::Block *block, bitArray &allRegsDefined,
+	                             const ParseAPI::CFGSnapshot *snap = NULL, unsigned id = 0);
 	
 	ReadWriteInfo calcRWSets(Instruction curInsn, ParseAPI::Block *blk, Address a);
 
@@ -73,6 +75,13 @@ class DATAFLOW_EXPORT LivenessAnalyzer{
 	int width;
 	ABI* abi;
 
+	// InstructionCache::get locks a global table, so remember the last one.
+	// 'cache' expires with its CodeObject, so a new CodeObject at the same
+	// address never sees the old one's cache.
+	std::shared_ptr<InstructionCache> getInstructionCache(ParseAPI::CodeObject *obj);
+	ParseAPI::CodeObject *cacheObj;
+	std::weak_ptr<InstructionCache> cache;
+
 public:
 	typedef enum {Before, After} Type;
 	typedef enum {Invalid_Location} ErrorType;
@@ -99,11 +99,35 @@ public:
             std::vector<VariableLocation> &locs,
             FrameErrors_t &err_result);
 
+    // Unwind rule for a PC range in the common shape
+    //   CFA = cfa_reg + cfa_offset
+    //   return address saved at CFA + ra_offset
+    //   frame pointer saved at CFA + fp_offset, or unchanged
+    // When DYNINST_COMPACT_UNWIND is set, all CFI rows of that shape are
+    // compiled into a sorted table on first use and looked up without
+    // locking. PCs without a row need getRegValueAtFrame.
+    struct UnwindRow {
+        Address lo;
+        Address hi;
+        MachRegister cfa_reg;
+        long cfa_offset;
+        long ra_offset;
+        long fp_offset;
+        bool fp_saved;
+    };
+
+    bool getUnwindRow(Address pc, UnwindRow &row);
 
 private:
 
     void setupCFIData();
 
+    void setupUnwindRows();
+    void compileUnwindRows(Dwarf_CFI *cfi, size_t cfi_index,
+            Elf *elf, const char *sec_name, bool eh_frame);
+    void compileFDERows(Dwarf_CFI *cfi, size_t cfi_index,
+            Address lo, Address hi);
+
     struct frameParser_key
     {
         Dwarf * dbg;
@@ -159,6 +183,9 @@ private:
     dyn_mutex cfi_lock;
     std::vector<Dwarf_CFI *> cfi_data;
 
+    boost::once_flag unwind_rows_once;
+    std::vector<UnwindRow> unwind_rows;
+
 };
 
 }
@@ -149,6 +149,13 @@ class CodeBuffer {
    ~CodeBuffer();
    
    void initialize(const codeGen &templ, unsigned numBlocks);
+   // Prepares a buffer for a contiguous run of RelocBlocks generated apart
+   // from the main buffer (e.g. on another thread); its labels start at
+   // firstLabel so they need no renumbering when it is appended.
+   void initializeFragment(const codeGen &templ, unsigned firstLabel);
+   // Moves a fragment's code to the end of this buffer. The fragment must
+   // start at the next label this buffer would have handed out.
+   void append(CodeBuffer &fragment);
    
    unsigned getLabel();
    unsigned defineLabel(Address addr);
@@ -190,6 +197,9 @@ class CodeBuffer {
 
    Labels labels_;
    int curLabelID_;
+   // labels_[0] holds this label; non-zero only in fragments
+   unsigned labelBase_;
+   Label &label(unsigned id);
 
    int shift_;
 
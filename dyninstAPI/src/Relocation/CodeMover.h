@@ -134,10 +134,7 @@ class CodeMover {
   CodeMover(CodeTracker *t);
   
   void setAddr(Address &addr) { addr_ = addr; }
-  template <typename RelocBlockIter>
-     bool addRelocBlocks(RelocBlockIter begin, RelocBlockIter end, func_instance *f);
-
-  bool addRelocBlock(block_instance *block, func_instance *f);
+  bool addRelocBlock(RelocBlock *relocBlock, block_instance *block, func_instance *f);
 
   void finalizeRelocBlocks();
 
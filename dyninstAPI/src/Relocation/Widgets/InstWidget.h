@@ -60,6 +60,8 @@ class InstWidget : public Widget {
   
   TrackerElement *tracker() const;
 
+  instPoint *point() const { return point_; }
+
   virtual ~InstWidget();
 
   virtual std::string format() const;
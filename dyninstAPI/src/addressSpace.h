@@ -164,6 +164,15 @@ class AddressSpace : public InstructionSource {
                                 u_int amount,
                                 const void *inSelf) = 0;
 
+    // Batched form of writeTextSpace, used when installing many small
+    // patches (e.g., springboards) at once. The default just iterates.
+    struct TextWrite {
+        Address addr;
+        u_int size;
+        const void *buf;
+    };
+    virtual bool writeTextSpaceV(const std::vector<TextWrite> &writes);
+
     Address getTOCoffsetInfo(func_instance *);
 
     // Memory allocation
@@ -322,6 +331,11 @@ class AddressSpace : public InstructionSource {
     // Do we have the RT-side multithread functions available
     virtual bool multithread_ready(bool ignore_if_mt_not_set = false) = 0;
 
+    // Offset of the RT library's thread index slot from the thread
+    // pointer, if it is known and the same for every thread. Used to
+    // generate an inline thread index load instead of a call.
+    virtual bool getThreadIndexSlot(long &) { return false; }
+
     //////////////////////////////////////////////////////
     // Process-level instrumentation (?)
     /////////////////////////////////////////////////////
@@ -889,6 +889,67 @@ class AstDynamicTargetNode : public AstNode {
                                      Dyninst::Address &retAddr,
                                      Dyninst::Register &retReg);
 };
+
+// Loads the RT library's per-thread index slot, which sits at a fixed
+// offset from the thread pointer. The offset is filled in by
+// AstThreadIndexNode right before code generation.
+class AstThreadSlotNode : public AstNode {
+ public:
+    AstThreadSlotNode() : offset_(0) {}
+
+    virtual ~AstThreadSlotNode() {}
+
+    virtual std::string format(std::string indent);
+
+    void setOffset(long offset) { offset_ = offset; }
+
+    virtual bool canBeKept() const { return false; }
+    virtual bool containsFuncCall() const { return false; }
+    virtual bool usesAppRegister() const { return false; }
+
+ private:
+    virtual bool generateCode_phase2(codeGen &gen,
+                                     bool noCost,
+                                     Dyninst::Address &retAddr,
+                                     Dyninst::Register &retReg);
+    long offset_;
+};
+
+// The 0...n thread index. If the process publishes the TLS slot used by
+// DYNINSTthreadIndex, this reads the slot inline and only calls into the
+// RT library the first time a thread asks for its index; otherwise it is
+// a plain call to DYNINSTthreadIndex.
+class AstThreadIndexNode : public AstNode {
+ public:
+    AstThreadIndexNode();
+
+    virtual ~AstThreadIndexNode() {}
+
+    virtual std::string format(std::string indent);
+
+    virtual int costHelper(enum CostStyleType costStyle) const;
+
+    // Constant for a given thread, so it can be reused within a snippet.
+    virtual bool canBeKept() const { return true; }
+    virtual bool containsFuncCall() const { return true; }
+    virtual bool usesAppRegister() const { return false; }
+
+    virtual void getChildren(std::vector<AstNodePtr> &children);
+
+ private:
+    virtual bool generateCode_phase2(codeGen &gen,
+                                     bool noCost,
+                                     Dyninst::Address &retAddr,
+                                     Dyninst::Register &retReg);
+
+    bool useInlineSlot(codeGen &gen);
+
+    AstNodePtr call_;
+    AstNodePtr inline_;
+    boost::shared_ptr<AstThreadSlotNode> slotTest_;
+    boost::shared_ptr<AstThreadSlotNode> slotLoad_;
+};
+
 class AstScrambleRegistersNode : public AstNode {
  public:
     AstScrambleRegistersNode() {}
@@ -71,6 +71,7 @@ class BinaryEdit : public AddressSpace {
     bool writeTextSpace(void *inOther,
                         u_int amount,
                         const void *inSelf);
+    bool writeTextSpaceV(const std::vector<TextWrite> &writes);
 
     // "Read"/"Write" to an address space with correct endian swapping.
     bool readDataWord(const void *inOther, 
@@ -214,7 +215,17 @@ class BinaryEdit : public AddressSpace {
    /* Function specific to rewritting static binaries */
    bool doStaticBinarySpecialCases();
     
-    codeRangeTree memoryTracker_;
+    // Backing store for the address space being rewritten. Kept sorted by
+    // start address so lookups are a binary search over a flat array; most
+    // accesses hit the same extent as the previous one, so that is checked
+    // first.
+    std::vector<memoryTracker *> memoryTracker_;
+    std::size_t lastTracker_;
+
+    memoryTracker *findTracker(Address addr);
+    void insertTracker(memoryTracker *tracker);
+    memoryTracker *removeTracker(Address addr);
+    bool copyToTrackers(Address addr, u_int size, const void *inSelf);
 
     mapped_object * addSharedObject(const std::string *fullPath);
 
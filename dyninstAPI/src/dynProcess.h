@@ -286,6 +286,7 @@ public:
     virtual Architecture getArch() const;
     virtual bool multithread_capable(bool ignoreIfMtNotSet = false); // platform-specific
     virtual bool multithread_ready(bool ignoreIfMtNotSet = false);
+    virtual bool getThreadIndexSlot(long &tpoff);
     virtual bool needsPIC();
     virtual void addTrap(Address from, Address to, codeGen &gen);
     virtual void removeTrap(Address from);
@@ -81,6 +81,8 @@ public:
 
     virtual bool emitLoadRelative(Register, Address, Register, int, codeGen &);
 
+    virtual bool emitLoadThreadPointerRelative(Register, long, codeGen &);
+
     virtual void
     emitLoadShared(opCode op, Register dest, const image_variable *var, bool is_local, int size, codeGen &gen,
                    Address offset);
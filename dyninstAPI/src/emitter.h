@@ -70,6 +70,9 @@ class Emitter {
     virtual bool emitCallRelative(Register, Address, Register, codeGen &) = 0;
     virtual bool emitLoadRelative(Register dest, Address offset, Register base, int size, codeGen &gen) = 0;
     virtual void emitLoadShared(opCode op, Register dest, const image_variable *var, bool is_local, int size, codeGen &gen, Address offset) = 0;
+    // Load a word at a fixed offset from the thread pointer. Returns false
+    // on platforms that do not support it.
+    virtual bool emitLoadThreadPointerRelative(Register, long, codeGen &) { return false; }
 
     virtual void emitLoadFrameAddr(Register dest, Address offset, codeGen &gen) = 0;
 
@@ -75,6 +75,7 @@ class trampTrapMappings {
    unsigned long table_used;
    unsigned long table_allocated;
    unsigned long table_mutatee_size;
+   Dyninst::Address table_max_from;
    Dyninst::Address current_table;
    Dyninst::Address table_header;
    bool blockFlushes;
@@ -89,7 +90,7 @@ class trampTrapMappings {
    bool definesTrapMapping(Dyninst::Address from);
    bool needsUpdating();
    void flush();
-   void allocateTable();
+   void allocateTable(bool rebuild);
    void shouldBlockFlushes(bool b) { blockFlushes = b; }
 
    bool empty();
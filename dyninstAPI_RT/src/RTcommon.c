@@ -145,6 +145,88 @@ DLLEXPORT void DYNINST_unlock_tramp_guard(void)
   DYNINST_tls_tramp_guard = 1;
 }
 
+// Thread index handed out by DYNINSTthreadIndex, stored as index + 1 so
+// that zero means "not assigned yet".  The mutator loads this directly
+// relative to the thread pointer when DYNINST_thread_index_tpoff is set,
+// and only calls DYNINSTthreadIndex while the slot is still zero.  This
+// file is the only place indices are assigned.
+static TLS_VAR long DYNINST_tls_thread_index = 0;
+static long DYNINST_next_thread_index = 0;
+static DECLARE_DYNINST_LOCK(DYNINST_thread_index_lock);
+DLLEXPORT long DYNINST_thread_index_tpoff = 0;
+
+// Indices of exited threads.  They are handed out again smallest first so
+// that the indices in use stay below the number of live threads.
+#define MAX_FREE_THREAD_INDICES 1024
+static long DYNINST_free_thread_indices[MAX_FREE_THREAD_INDICES];
+static int DYNINST_num_free_thread_indices = 0;
+
+static long allocThreadIndex(void)
+{
+   int i, min = -1;
+   long index;
+   for (i = 0; i < DYNINST_num_free_thread_indices; i++) {
+      if (min == -1 || DYNINST_free_thread_indices[i] < DYNINST_free_thread_indices[min])
+         min = i;
+   }
+   if (min == -1)
+      return DYNINST_next_thread_index++;
+   index = DYNINST_free_thread_indices[min];
+   DYNINST_free_thread_indices[min] =
+      DYNINST_free_thread_indices[--DYNINST_num_free_thread_indices];
+   return index;
+}
+
+#if !defined(_MSC_VER)
+#include <pthread.h>
+#pragma weak pthread_key_create
+#pragma weak pthread_setspecific
+
+static pthread_key_t DYNINST_thread_index_key;
+static int DYNINST_thread_index_key_valid = 0;
+
+static void releaseThreadIndex(void *slot)
+{
+   tc_lock_lock(&DYNINST_thread_index_lock);
+   if (DYNINST_num_free_thread_indices < MAX_FREE_THREAD_INDICES) {
+      DYNINST_free_thread_indices[DYNINST_num_free_thread_indices++] =
+         (long) slot - 1;
+   }
+   tc_lock_unlock(&DYNINST_thread_index_lock);
+   DYNINST_tls_thread_index = 0;
+}
+#endif
+
+static void initThreadIndex(void)
+{
+#if !defined(_MSC_VER)
+   char *tp;
+   if (!DYNINST_thread_index_key_valid && pthread_key_create &&
+       pthread_key_create(&DYNINST_thread_index_key, releaseThreadIndex) == 0)
+      DYNINST_thread_index_key_valid = 1;
+
+   tp = (char *) DYNINST_thread_pointer();
+   if (tp)
+      DYNINST_thread_index_tpoff = (char *) &DYNINST_tls_thread_index - tp;
+#endif
+}
+
+DLLEXPORT int DYNINSTthreadIndex(void)
+{
+   if (!DYNINST_tls_thread_index) {
+      tc_lock_lock(&DYNINST_thread_index_lock);
+      DYNINST_tls_thread_index = allocThreadIndex() + 1;
+      tc_lock_unlock(&DYNINST_thread_index_lock);
+#if !defined(_MSC_VER)
+      // Hand the index back when the thread exits
+      if (DYNINST_thread_index_key_valid && pthread_setspecific)
+         pthread_setspecific(DYNINST_thread_index_key,
+                             (void *) DYNINST_tls_thread_index);
+#endif
+   }
+   return (int) (DYNINST_tls_thread_index - 1);
+}
+
 DECLARE_DYNINST_LOCK(DYNINST_trace_lock);
 
 /**
@@ -170,6 +252,7 @@ void DYNINSTBaseInit(void)
    DYNINSTinitializeTrapHandler();
 #endif
    DYNINST_unlock_tramp_guard();
+   initThreadIndex();
    DYNINSThasInitialized = 1;
 }
 
@@ -192,6 +275,7 @@ void DYNINSTinit(void)
    mark_heaps_exec();
 
    tc_lock_init(&DYNINST_trace_lock);
+   initThreadIndex();
    DYNINSThasInitialized = 1;
    rtdebug_printf("%s[%d]:  welcome to DYNINSTinit\n", __FILE__, __LINE__);
 
@@ -686,51 +770,59 @@ DLLEXPORT volatile unsigned long dyninstTrapTableVersion;
 DLLEXPORT volatile trapMapping_t *dyninstTrapTable;
 DLLEXPORT volatile unsigned long dyninstTrapTableIsSorted;
 
+/**
+ * Look up the relocated address for a trap at source.  This runs from the
+ * SIGTRAP handler, so it must not allocate or print.
+ *
+ * The mutator keeps the table sorted by source address and publishes a new
+ * table by writing the table pointer and size before bumping the version,
+ * so we snapshot the table, search it, and retry if the version moved.
+ **/
 void* dyninstTrapTranslate(void *source,
                            volatile unsigned long *table_used,
                            volatile unsigned long *table_version,
                            volatile trapMapping_t **trap_table,
                            volatile unsigned long *is_sorted)
 {
-   volatile unsigned local_version;
-   unsigned i;
+   unsigned long local_version;
+   volatile trapMapping_t *table;
+   unsigned long used;
+   unsigned long i;
    void *target;
 
    do {
       local_version = *table_version;
+      table = *trap_table;
+      used = *table_used;
       target = NULL;
 
+      if (!table || !used)
+         continue;
+
       if (*is_sorted)
       {
-         unsigned min = 0;
-         unsigned mid = 0;
-         unsigned max = *table_used;
-         unsigned prev = max+1;
-
-         for (;;) {
-            mid = (min + max) / 2;
-            if (mid == prev) {
-                fprintf(stderr,"ERROR: dyninstTrapTranslate couldn't find "
-                        "entry for %p: min=%x mid=%x max=%x prev=%x\n",
-                        source,min,mid,max,prev);
-               break;
-            }
-            prev = mid;
+         /* Half-open binary search over [min, max) */
+         unsigned long min = 0;
+         unsigned long max = used;
+
+         while (min < max) {
+            unsigned long mid = min + (max - min) / 2;
+            void *cur = table[mid].source;
 
-            if ((*trap_table)[mid].source < source)
-               min = mid;
-            else if ((*trap_table)[mid].source > source)
+            if (cur < source)
+               min = mid + 1;
+            else if (cur > source)
                max = mid;
             else {
-               target = (*trap_table)[mid].target;
+               target = table[mid].target;
                break;
             }
          }
       }
       else { /*!dyninstTrapTableIsSorted*/
-         for (i = 0; i<*table_used; i++) {
-            if ((*trap_table)[i].source == source) {
-               target = (*trap_table)[i].target;
+         for (i = 0; i < used; i++) {
+            if (table[i].source == source) {
+               target = table[i].target;
                break;
             }
          }
@@ -38,3 +38,10 @@ int tc_lock_lock(tc_lock_t *t)
       if (t->tid == me) return DYNINST_DEAD_LOCK;
   return 0;
 }
+
+void *DYNINST_thread_pointer(void)
+{
+   void *tp;
+   __asm__ ("mrs %0, tpidr_el0" : "=r" (tp));
+   return tp;
+}
@@ -59,3 +59,9 @@ int tc_lock_lock(tc_lock_t *tc)
    }
    return 0;
 }
+
+void *DYNINST_thread_pointer(void)
+{
+   /* No inline thread index on POWER; the mutator falls back to a call */
+   return NULL;
+}
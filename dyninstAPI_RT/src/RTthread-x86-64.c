@@ -54,3 +54,10 @@ int tc_lock_lock(tc_lock_t *tc)
    return 0;
 }
 
+void *DYNINST_thread_pointer(void)
+{
+   /* The TCB header starts with a pointer to itself */
+   void *tp;
+   __asm__ ("mov %%fs:0, %0" : "=r" (tp));
+   return tp;
+}
@@ -87,3 +87,9 @@ int tc_lock_lock(tc_lock_t *tc)
    tc->tid = me;
    return 0;
 }
+
+void *DYNINST_thread_pointer(void)
+{
+   /* No inline thread index on IA-32; the mutator falls back to a call */
+   return NULL;
+}
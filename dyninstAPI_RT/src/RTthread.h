@@ -52,4 +52,8 @@ int tc_lock_destroy(tc_lock_t*);
 
 int DYNINST_am_initial_thread(dyntid_t tid);
 
+/* Current thread pointer (%fs base, tpidr_el0, ...), or NULL where the
+   mutator cannot generate thread-pointer-relative loads */
+void *DYNINST_thread_pointer(void);
+
 #endif
@@ -134,7 +134,8 @@ namespace Dyninst
       virtual const Result& eval() const;
   
       /// \param knownValue Sets the result of \c eval for this %Expression
-      /// to \c knownValue
+      /// to \c knownValue.  Interned immediates (see Immediate::makeImmediate)
+      /// are shared and keep their value.
       void setValue(const Result& knownValue);
   
       /// \c clearValue sets the contents of this %Expression to undefined.
@@ -170,6 +171,9 @@ namespace Dyninst
     protected:
       virtual bool isFlag() const;
       Result userSetValue;
+      // Set on objects shared between instructions, which setValue and
+      // clearValue must leave alone
+      bool interned_;
       
     };
     class INSTRUCTION_EXPORT DummyExpr : public Expression
@@ -67,6 +67,9 @@ namespace Dyninst
 
       virtual std::string format(Architecture, formatStyle) const;
       virtual std::string format(formatStyle) const;
+      /// Small integer immediates are interned: repeated requests for the same type and
+      /// value return the same %Immediate object, on which \c setValue and \c clearValue
+      /// have no effect.
       static Immediate::Ptr makeImmediate(const Result& val);
       virtual void apply(Visitor* v);
       
@@ -33,6 +33,7 @@
 
 #include "Instruction.h"
 #include <stddef.h>
+#include <vector>
 
 namespace Dyninst
 {
@@ -47,6 +48,24 @@ namespace Dyninst
     ///
       class InstructionDecoderImpl;
 
+    /// A %PackedInstruction is a compact, trivially copyable summary of a decoded instruction,
+    /// intended for linear sweeps that only need the opcode, size and category of each
+    /// instruction.  The operand ASTs are not kept; \c inflate re-decodes the raw bytes into a
+    /// full %Instruction when a client needs them.
+    struct INSTRUCTION_EXPORT PackedInstruction
+    {
+        entryID id;
+        InsnCategory category;
+        Architecture arch;
+        unsigned char length;
+        bool legal;
+        unsigned char bytes[16];
+
+        size_t size() const { return length; }
+        /// Decode the raw bytes of this instruction into a full %Instruction.
+        Instruction inflate() const;
+    };
+
     class INSTRUCTION_EXPORT InstructionDecoder
     {
       friend class Instruction;
@@ -71,6 +90,10 @@ namespace Dyninst
       /// the size of the instruction decoded.
       Instruction decode(const unsigned char *buffer);
       void doDelayedDecode(const Instruction* insn_to_complete);
+      /// Decode the instructions in the \c len bytes starting at \c buf, appending a
+      /// %PackedInstruction for each to \c out.  Decoding stops at the end of the range or at
+      /// the first byte sequence that cannot be decoded.  Returns the number of bytes consumed.
+      size_t decodeRange(const unsigned char* buf, size_t len, std::vector<PackedInstruction>& out);
       struct INSTRUCTION_EXPORT buffer
       {
           const unsigned char* start;
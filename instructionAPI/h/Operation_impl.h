@@ -41,8 +41,6 @@
 #include <mutex>
 
 #include "util.h"
-#include <boost/thread/lockable_adapter.hpp>
-#include <boost/thread/recursive_mutex.hpp>
 #include <boost/flyweight.hpp>
 
 // OpCode = operation + encoding
@@ -96,7 +94,7 @@ namespace Dyninst
     /// %Operations are constructed by the %InstructionDecoder as part of the process
     /// of constructing an %Instruction.
     
-    class Operation : public boost::lockable_adapter<boost::recursive_mutex>
+    class Operation
     {
     public:
       typedef std::set<RegisterAST::Ptr> registerSet;
@@ -149,7 +147,9 @@ namespace Dyninst
       bool isVectorInsn;
 
     private:
-        std::once_flag data_initialized;
+      // The implicit read/write sets are built once on first use and are immutable
+      // afterwards, so no per-operation lock is needed to read them.
+      std::once_flag data_initialized;
       void SetUpNonOperandData();
       
       mutable registerSet otherRead;
@@ -662,10 +662,23 @@ class PARSER_EXPORT Function : public AnnotatableSparse, public boost::lockable_
     std::map<Address, JumpTableInstance> jumptables;
 
     /* Dominator and post-dominator info details */
-    mutable bool isDominatorInfoReady;
-    mutable bool isPostDominatorInfoReady;
+    mutable boost::atomic<bool> isDominatorInfoReady;
+    mutable boost::atomic<bool> isPostDominatorInfoReady;
     void fillDominatorInfo() const;
     void fillPostDominatorInfo() const;
+    /** Pre-order interval numbering of a dominator tree. A dominates B
+        iff pre[A] <= pre[B] <= last[pre[A]]. Immutable once the
+        corresponding ready flag is set, so queries need no lock. */
+    struct DomIntervals {
+        dyn_hash_map<Block*, unsigned> pre;
+        std::vector<unsigned> last;
+        void build(const_blocklist blocks,
+                   const std::map<Block*, Block*> &idom,
+                   const std::map<Block*, std::set<Block*>*> &children);
+        bool contains(Block *A, Block *B) const;
+    };
+    mutable DomIntervals domIntervals;
+    mutable DomIntervals postDomIntervals;
     /** set of basic blocks that this basicblock dominates immediately*/
     mutable std::map<Block*, std::set<Block*>*> immediateDominates;
     /** basic block which is the immediate dominator of the basic block */
@@ -0,0 +1,124 @@
+/*
+ * See the dyninst/COPYRIGHT file for copyright information.
+ * 
+ * We provide the Paradyn Tools (below described as "Paradyn")
+ * on an AS IS basis, and do not warrant its validity or performance.
+ * We reserve the right to update, modify, or discontinue this
+ * software at any time.  We shall have no obligation to supply such
+ * updates or modifications or any other form of support to you.
+ * 
+ * By your use of Paradyn, you understand and agree that we (or any
+ * other person or entity with proprietary rights in Paradyn) are
+ * under no obligation to provide either maintenance services,
+ * update services, notices of latent defects, or correction of
+ * defects for Paradyn.
+ * 
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef _CFG_SNAPSHOT_H_
+#define _CFG_SNAPSHOT_H_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/range/iterator_range.hpp>
+#include "dyntypes.h"
+#include "CFG.h"
+
+namespace Dyninst {
+namespace ParseAPI {
+
+class CodeObject;
+
+/** An immutable compressed-sparse-row copy of a finalized CFG, for
+    analyses that traverse whole functions or whole programs.
+
+    Every block reachable from a function gets a dense id in
+    [0, numBlocks()); successor and predecessor lists are contiguous
+    slices of two shared arc arrays. Functions are slices of a block id
+    array. The snapshot does not change when the live CFG does; its
+    Block, Edge and Function pointers are valid only as long as those
+    objects are.
+**/
+class PARSER_EXPORT CFGSnapshot {
+ public:
+    typedef boost::shared_ptr<const CFGSnapshot> Ptr;
+
+    // Id of the sink block, and result of failed lookups
+    static const unsigned NoId = ~0U;
+
+    struct Arc {
+        unsigned block;     // target for successors, source for predecessors
+        EdgeTypeEnum type;
+        bool interproc;
+        Edge *edge;
+    };
+    typedef boost::iterator_range<const Arc *> arclist;
+    typedef boost::iterator_range<const unsigned *> idlist;
+
+    unsigned numBlocks() const { return blocks_.size(); }
+    Block *block(unsigned id) const { return blocks_[id]; }
+    unsigned id(Block *b) const;
+    arclist successors(unsigned id) const {
+        return arclist(succs_.data() + succ_offsets_[id],
+                       succs_.data() + succ_offsets_[id + 1]);
+    }
+    // Successor arcs are numbered contiguously: the k-th successor of
+    // block id is arc firstArc(id) + k
+    unsigned numArcs() const { return succs_.size(); }
+    unsigned firstArc(unsigned id) const { return succ_offsets_[id]; }
+    arclist predecessors(unsigned id) const {
+        return arclist(preds_.data() + pred_offsets_[id],
+                       preds_.data() + pred_offsets_[id + 1]);
+    }
+
+    unsigned numFunctions() const { return funcs_.size(); }
+    Function *function(unsigned fid) const { return funcs_[fid]; }
+    unsigned functionId(const Function *f) const;
+    unsigned functionEntry(unsigned fid) const { return func_entries_[fid]; }
+    idlist functionBlocks(unsigned fid) const {
+        return idlist(func_blocks_.data() + func_block_offsets_[fid],
+                      func_blocks_.data() + func_block_offsets_[fid + 1]);
+    }
+    idlist functionExits(unsigned fid) const {
+        return idlist(func_exits_.data() + func_exit_offsets_[fid],
+                      func_exits_.data() + func_exit_offsets_[fid + 1]);
+    }
+
+ private:
+    friend class CodeObject;
+    explicit CFGSnapshot(CodeObject *obj);
+    unsigned addBlock(Block *b);
+
+    std::vector<Block *> blocks_;
+    dyn_hash_map<Block *, unsigned> block_ids_;
+    std::vector<unsigned> succ_offsets_;
+    std::vector<Arc> succs_;
+    std::vector<unsigned> pred_offsets_;
+    std::vector<Arc> preds_;
+
+    std::vector<Function *> funcs_;
+    dyn_hash_map<const Function *, unsigned> func_ids_;
+    std::vector<unsigned> func_entries_;
+    std::vector<unsigned> func_block_offsets_;
+    std::vector<unsigned> func_blocks_;
+    std::vector<unsigned> func_exit_offsets_;
+    std::vector<unsigned> func_exits_;
+};
+
+}
+}
+
+#endif
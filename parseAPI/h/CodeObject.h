@@ -42,6 +42,7 @@
 #include "CodeSource.h"
 #include "CFGFactory.h"
 #include "CFG.h"
+#include "CFGSnapshot.h"
 #include "ParseContainers.h"
 
 namespace Dyninst {
@@ -153,6 +154,15 @@ class CodeObject {
      */
     PARSER_EXPORT void finalize();
 
+    /*
+     * Freeze the finalized CFG into a CFGSnapshot. The same snapshot is
+     * returned until the CFG is next changed through this CodeObject;
+     * while it is current, Function's loop and dominator analyses run
+     * on it.
+     */
+    PARSER_EXPORT CFGSnapshot::Ptr snapshot();
+    PARSER_EXPORT CFGSnapshot::Ptr currentSnapshot() const;
+
     /*
      * Deletion support
      */
@@ -169,6 +179,7 @@ class CodeObject {
  private:
     void process_hints();
     void add_edge(Block *src, Block *trg, EdgeTypeEnum et);
+    void dropSnapshot();
     // allows Functions to link up return edges after-the-fact
     friend void Function::delayed_link_return(CodeObject *,Block*);
     // allows Functions to finalize (need Parser access)
@@ -186,6 +197,7 @@ class CodeObject {
     bool owns_factory;
     bool defensive;
     funclist& flist;
+    CFGSnapshot::Ptr _snapshot;
 };
 
 // We need CFG.h, which is included by this
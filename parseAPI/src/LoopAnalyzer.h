@@ -36,6 +36,7 @@
 #include <map>
 #include "Annotatable.h"
 #include "CFG.h"
+#include "CFGSnapshot.h"
 
 using namespace std;
 
@@ -53,6 +54,7 @@ class LoopAnalyzer {
  
   
   const Function *func;
+  const CFGSnapshot *snap;
   std::map<Block*, set<Block*> > loop_tree;
   std::map<Block*, Loop*> loops;
 
@@ -62,6 +64,7 @@ class LoopAnalyzer {
 
   Block* WMZC_DFS(Block* b0, int pos);
   void WMZC_TagHead(Block* b, Block* h);
+  void getIntraTargets(Block *b, vector<Edge*> &edges) const;
   void FillMoreBackEdges(Loop *loop);
   void dfsCreateLoopHierarchy(LoopTreeNode * parent,
                               vector<Loop *> &loops,
@@ -72,7 +75,7 @@ public:
   /** create the tree of loops/callees for this flow graph */
   void createLoopHierarchy();
  
-  LoopAnalyzer (const Function *f);
+  LoopAnalyzer (const Function *f, const CFGSnapshot *s = NULL);
 
 
   
@@ -181,15 +181,169 @@ class edge_parsing_data {
 };
 
 
+/*
+ * Interval index split into fixed-size address shards, each its own
+ * IBSTree_fast with its own lock.  Threads inserting or looking up
+ * intervals in different parts of a large region no longer serialize
+ * on a single tree lock.  An interval that crosses a shard boundary is
+ * stored in every shard it overlaps, so point lookups only ever need
+ * the one shard containing the address.
+ *
+ * The shard directory is a fixed array covering the bounds given to
+ * set_bounds, so finding a shard takes no lock; shards themselves are
+ * created on first use and published with a compare-and-swap.  Anything
+ * outside the bounds (e.g., regions added during hybrid analysis) goes
+ * to one extra overflow shard.
+ *
+ * This only removes the single index lock; it does not change how
+ * parsing is scheduled.  Frames are still parsed by the Parser's OpenMP
+ * tasks, with no per-shard work queues, and since blocks and edges go
+ * straight into the shared CFG there is no cross-shard merge step.
+ * Range finalization is still serial.
+ */
+template <typename ITYPE>
+class sharded_range_index {
+public:
+    typedef typename ITYPE::type interval_type;
+    typedef Dyninst::IBSTree_fast<ITYPE> shard_t;
+
+    // 1 MB of address space per shard
+    static const unsigned shard_bits = 20;
+    // Cap on the directory size; the rest of the range overflows
+    static const unsigned max_shards = 1 << 16;
+
+    sharded_range_index() : base(0), nshards(0), shards(NULL) {
+        alloc_shards();
+    }
+    ~sharded_range_index() { clear_shards(); }
+
+    // Must be called before the index is shared between threads
+    void set_bounds(interval_type lo, interval_type hi) {
+        clear_shards();
+        base = shard_base(lo);
+        nshards = 0;
+        if (hi > lo) {
+            interval_type n = ((hi - 1 - base) >> shard_bits) + 1;
+            nshards = n > max_shards ? max_shards : (unsigned) n;
+        }
+        alloc_shards();
+    }
+
+    void insert(ITYPE *entry) {
+        for_shards(entry->low(), last_addr(entry), true,
+                   [entry](shard_t *s) { s->insert(entry); });
+    }
+    void remove(ITYPE *entry) {
+        for_shards(entry->low(), last_addr(entry), false,
+                   [entry](shard_t *s) { s->remove(entry); });
+    }
+    int find(interval_type X, std::set<ITYPE*> &results) const {
+        shard_t *s = shards[index(X)].load(boost::memory_order_acquire);
+        if (!s) return 0;
+        return s->find(X, results);
+    }
+    int find(ITYPE *I, std::set<ITYPE*> &results) const {
+        int num_old_results = results.size();
+        if (I->high() <= I->low()) return 0;
+        for_shards(I->low(), I->high() - 1, false,
+                   [I, &results](shard_t *s) { s->find(I, results); });
+        return results.size() - num_old_results;
+    }
+    // The interval containing X, or else the first one after it
+    ITYPE* successor(interval_type X) const {
+        shard_t *overflow = shards[nshards].load(boost::memory_order_acquire);
+        ITYPE *below = NULL;
+        unsigned i = nshards;
+        if (in_bounds(X)) {
+            i = index(X);
+        } else if (X < base) {
+            // Intervals in the overflow shard that start below the bounds
+            // come before anything in the directory
+            below = overflow ? overflow->successor(X) : NULL;
+            if (below && below->low() < base) return below;
+            i = 0;
+        }
+        for (; i < nshards; ++i) {
+            shard_t *s = shards[i].load(boost::memory_order_acquire);
+            if (!s) continue;
+            ITYPE *ret = s->successor(X);
+            if (ret) return ret;
+        }
+        if (X < base) return below;
+        return overflow ? overflow->successor(X) : NULL;
+    }
+
+private:
+    static interval_type shard_size() { return ((interval_type) 1) << shard_bits; }
+    static interval_type shard_base(interval_type a) { return a & ~(shard_size() - 1); }
+    static interval_type last_addr(ITYPE *entry) {
+        return entry->high() > entry->low() ? entry->high() - 1 : entry->low();
+    }
+
+    bool in_bounds(interval_type a) const {
+        return a >= base && ((a - base) >> shard_bits) < nshards;
+    }
+    // The overflow shard lives at index nshards
+    unsigned index(interval_type a) const {
+        return in_bounds(a) ? (unsigned) ((a - base) >> shard_bits) : nshards;
+    }
+
+    shard_t *get_or_create(unsigned i) const {
+        shard_t *s = shards[i].load(boost::memory_order_acquire);
+        if (s) return s;
+        shard_t *fresh = new shard_t();
+        if (shards[i].compare_exchange_strong(s, fresh, boost::memory_order_acq_rel))
+            return fresh;
+        delete fresh;
+        return s;
+    }
+
+    // Applies f to every shard overlapping [lo, last], including the
+    // overflow shard if the range leaves the bounds.
+    template <typename F>
+    void for_shards(interval_type lo, interval_type last, bool create, F f) const {
+        if (lo < base || !in_bounds(last)) {
+            shard_t *s = create ? get_or_create(nshards)
+                                : shards[nshards].load(boost::memory_order_acquire);
+            if (s) f(s);
+        }
+        if (nshards == 0 || last < base || !(lo < base || in_bounds(lo))) return;
+        unsigned first = lo < base ? 0 : index(lo);
+        unsigned end = in_bounds(last) ? index(last) : nshards - 1;
+        for (unsigned i = first; i <= end; ++i) {
+            shard_t *s = create ? get_or_create(i)
+                                : shards[i].load(boost::memory_order_acquire);
+            if (s) f(s);
+        }
+    }
+
+    void alloc_shards() {
+        shards = new boost::atomic<shard_t *>[nshards + 1];
+        for (unsigned i = 0; i <= nshards; ++i)
+            shards[i].store(NULL);
+    }
+    void clear_shards() {
+        if (!shards) return;
+        for (unsigned i = 0; i <= nshards; ++i)
+            delete shards[i].load();
+        delete [] shards;
+        shards = NULL;
+    }
+
+    interval_type base;
+    unsigned nshards;
+    boost::atomic<shard_t *> *shards;
+};
+
 /* per-CodeRegion parsing data */
 class region_data {
 public:
     // Function lookups
-    Dyninst::IBSTree_fast<FuncExtent> funcsByRange;
+    sharded_range_index<FuncExtent> funcsByRange;
     dyn_c_hash_map<Address, Function *> funcsByAddr;
 
     // Block lookups
-    Dyninst::IBSTree_fast<Block > blocksByRange;
+    sharded_range_index<Block> blocksByRange;
     dyn_c_hash_map<Address, Block *> blocksByAddr;
 
     // Parsing internals 
@@ -201,6 +355,12 @@ public:
     typedef dyn_c_hash_map<Address, edge_parsing_data> edge_data_map;
     edge_data_map edge_parsing_status;
 
+    // Sizes the range indices; call before parsing starts
+    void set_bounds(Address lo, Address hi) {
+        funcsByRange.set_bounds(lo, hi);
+        blocksByRange.set_bounds(lo, hi);
+    }
+
     Function * findFunc(Address entry);
     Block * findBlock(Address entry);
     int findFuncs(Address addr, set<Function *> & funcs);
@@ -33,6 +33,7 @@
 
 #include "dyntypes.h"
 #include "CFG.h"
+#include "CFGSnapshot.h"
 #include <unordered_map>
 #include <set>
 
@@ -75,6 +76,7 @@ class dominatorCFG {
  protected:
    std::unordered_map<Address, dominatorBB *> map_;
    const Function *func;
+   const CFGSnapshot *snap;
    vector<dominatorBB *> all_blocks;
    vector<dominatorBB *> sorted_blocks;
    int currentDepthNo;
@@ -87,9 +89,10 @@ class dominatorCFG {
    void eval(dominatorBB *v);
    void link(dominatorBB *v, dominatorBB *w);
    dominatorBB *parseToDomBB(Block *bb);
+   bool linkFromSnapshot(bool post);
 
  public:
-   dominatorCFG(const Function *f);
+   dominatorCFG(const Function *f, const CFGSnapshot *s = NULL);
    ~dominatorCFG();
 
    void calcDominators();
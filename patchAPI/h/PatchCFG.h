@@ -33,6 +33,8 @@
 #define _PATCHAPI_DYNINST_CFG_H_
 
 #include <assert.h>
+#include <stdint.h>
+#include <atomic>
 #include <map>
 #include <set>
 #include <string>
@@ -167,10 +169,19 @@ class PATCHAPI_EXPORT PatchBlock {
     int numRetEdges() const;
     int numCallEdges() const;
 
+    // Instruction start offsets from start(), so that getInsn can decode
+    // a single instruction instead of the whole block. Built on first
+    // use, within a process-wide memory budget; instructions themselves
+    // are never retained.
+    typedef std::vector<uint16_t> InsnIndex;
+    const InsnIndex *insnIndex() const;
+    void dropInsnIndex();
+
     ParseAPI::Block *block_;
     edgelist srclist_;
     edgelist trglist_;
     PatchObject* obj_;
+    mutable std::atomic<InsnIndex *> insn_index_;
 
     BlockPoints points_;
 };
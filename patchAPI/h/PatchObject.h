@@ -34,9 +34,11 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "PatchCommon.h"
 #include "CFGMaker.h"
+#include "CFGSnapshot.h"
 
 namespace Dyninst {
 namespace PatchAPI {
@@ -102,6 +104,25 @@ class PATCHAPI_EXPORT PatchObject {
     template <class Iter>
       void edges(Iter iter); 
 
+    // Bulk creation
+    // Create wrappers for every function, block and edge of the code
+    // object at once (in parallel if the CFGMaker allows it) and index
+    // them by the ids of the code object's CFGSnapshot. Afterwards
+    // getFunc/getBlock/getEdge look up wrappers in flat arrays instead
+    // of the maps; entities parsed later still go through the maps.
+    void materialize();
+    ParseAPI::CFGSnapshot::Ptr snapshot() const { return snapshot_; }
+    // NULL for ids outside the materialized snapshot
+    PatchFunction *getFuncById(unsigned id) const {
+      return id < flat_funcs_.size() ? flat_funcs_[id] : NULL;
+    }
+    PatchBlock *getBlockById(unsigned id) const {
+      return id < flat_blocks_.size() ? flat_blocks_[id] : NULL;
+    }
+    PatchEdge *getEdgeByArc(unsigned arc) const {
+      return arc < flat_edges_.size() ? flat_edges_[arc] : NULL;
+    }
+
     PatchCallback *cb() const { return cb_; }
 
     bool consistency(const AddrSpace *as) const;
@@ -125,6 +146,17 @@ class PATCHAPI_EXPORT PatchObject {
     void createBlocks();
     void createEdges();
 
+    unsigned flatFuncId(const ParseAPI::Function *f) const;
+    unsigned flatBlockId(ParseAPI::Block *b) const;
+    unsigned flatEdgeId(ParseAPI::Edge *e) const;
+
+    ParseAPI::CFGSnapshot::Ptr snapshot_;
+    std::vector<PatchFunction *> flat_funcs_;
+    std::vector<PatchBlock *> flat_blocks_;
+    std::vector<PatchEdge *> flat_edges_;
+    // Arc of each snapshot edge, so lookups don't scan successor lists
+    std::unordered_map<const ParseAPI::Edge *, unsigned> flat_edge_ids_;
+
     PatchCallback *cb_;
     PatchParseCallback *pcb_;
 };
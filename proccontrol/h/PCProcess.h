@@ -471,6 +471,34 @@ class PC_EXPORT Process : public boost::enable_shared_from_this<Process>
    bool writeMemoryAsync(Dyninst::Address addr, const void *buffer, size_t size, void *opaque_val = NULL) const;
    bool readMemoryAsync(void *buffer, Dyninst::Address addr, size_t size, void *opaque_val = NULL) const;
 
+   /**
+    * Scatter-gather read.  Each element is read from addr into buffer, and
+    * its err field is set to err_none or an error code.  Where the platform
+    * supports it (process_vm_readv on Linux) the whole set costs one system call.
+    **/
+   struct read_t {
+      Dyninst::Address addr;
+      void *buffer;
+      size_t size;
+      err_t err;
+      bool operator<(const read_t &w) { return (addr < w.addr) && (size < w.size) && (buffer < w.buffer); }
+   };
+   bool readMemoryV(std::vector<read_t> &reads) const;
+
+   /**
+    * Running totals for readMemoryV.  Adjacent and overlapping reads are
+    * coalesced before being issued, so 'ranges' and 'syscalls' show how
+    * much work the batches actually cost compared to 'reads'.
+    **/
+   struct read_stats_t {
+      unsigned long reads;            //read_t elements requested
+      unsigned long bytes_requested;  //Sum of their sizes
+      unsigned long ranges;           //Ranges left after coalescing
+      unsigned long bytes_read;       //Bytes transferred from the process
+      unsigned long syscalls;         //System calls issued for the transfers
+   };
+   read_stats_t getReadMemoryVStats() const;
+
    /** 
     * Currently Windows-only, needed for the test infrastructure but possibly useful elsewhere 
     **/
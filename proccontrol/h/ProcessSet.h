@@ -355,17 +355,16 @@ class PC_EXPORT ProcessSet : public boost::enable_shared_from_this<ProcessSet>
       err_t err;
       bool operator<(const write_t &w) { return (addr < w.addr) && (size < w.size) && (buffer < w.buffer); }
    };
-   struct read_t {
-      Dyninst::Address addr;
-      void *buffer;
-      size_t size;
-      err_t err;
-      bool operator<(const read_t &w) { return (addr < w.addr) && (size < w.size) && (buffer < w.buffer); }
-   };
+   typedef Process::read_t read_t;
 
    bool readMemory(AddressSet::ptr addr, std::multimap<Process::ptr, void *> &result, size_t size) const;
    bool readMemory(AddressSet::ptr addr, std::map<void *, ProcessSet::ptr> &result, size_t size, bool use_checksum = true) const;
    bool readMemory(std::multimap<Process::const_ptr, read_t> &addrs) const;
+   //Like the read_t form of readMemory, but all reads against a process are
+   // coalesced and serviced by a single vectored request.
+   bool readMemoryV(std::multimap<Process::const_ptr, read_t> &addrs) const;
+   //Sum of Process::getReadMemoryVStats over the set
+   Process::read_stats_t getReadMemoryVStats() const;
 
    bool writeMemory(AddressSet::ptr addr, const void *buffer, size_t size) const;
    bool writeMemory(std::multimap<Process::const_ptr, write_t> &addrs) const;
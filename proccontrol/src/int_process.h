@@ -430,13 +430,27 @@ class int_process
       bp_clear
    };
 
+   //One element of a scatter-gather memory read.  'error' is set on
+   // return for each element that could not be read.
+   struct mem_iov_t {
+      Dyninst::Address remote;
+      void *local;
+      size_t size;
+      bool error;
+   };
+
    bool readMem(Dyninst::Address remote, mem_response::ptr result, int_thread *thr = NULL);
    bool writeMem(const void *local, Dyninst::Address remote, size_t size, result_response::ptr result, int_thread *thr = NULL, bp_write_t bp_write = not_bp);
+   bool readMemV(std::vector<mem_iov_t> &iovs, int_thread *thr = NULL);
+   Process::read_stats_t &getReadStats() { return read_stats; }
 
    virtual bool plat_readMem(int_thread *thr, void *local,
                              Dyninst::Address remote, size_t size) = 0;
    virtual bool plat_writeMem(int_thread *thr, const void *local,
                               Dyninst::Address remote, size_t size, bp_write_t bp_write) = 0;
+   //Platforms that can service several reads with one system call override
+   // this.  The default issues one plat_readMem per element.
+   virtual bool plat_readMemV(int_thread *thr, std::vector<mem_iov_t> &iovs);
 
    virtual async_ret_t plat_calcTLSAddress(int_thread *thread, int_library *lib, Offset off,
                                            Address &outaddr, std::set<response::ptr> &resps);
@@ -551,6 +565,8 @@ class int_process
    int_callStackUnwinding *getCallStackUnwinding();
    int_remoteIO *getRemoteIO();
  protected:
+   bool readMemVCoalesced(std::vector<mem_iov_t> &iovs, int_thread *thr);
+
    State state;
    Dyninst::PID pid;
    creationMode_t creation_mode;
@@ -575,6 +591,7 @@ class int_process
    int continueSig;
    bool createdViaAttach;
    memCache mem_cache;
+   Process::read_stats_t read_stats;
    Counter async_event_count;
    Counter force_generator_block_count;
    Counter startupteardown_procs;
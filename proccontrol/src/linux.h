@@ -49,7 +49,9 @@
 #include "processplat.h"
 
 #include "common/src/dthread.h"
+#include <atomic>
 #include <map>
+#include <memory>
 #include <stddef.h>
 #include <string>
 #include <vector>
@@ -104,6 +106,8 @@ class DecoderLinux : public Decoder
    Dyninst::Address adjustTrapAddr(Dyninst::Address address, Dyninst::Architecture arch);
 };
 
+class LinuxPtrace;
+
 class linux_process : public sysv_process, public unix_process, public thread_db_process, public indep_lwp_control_process, public mmap_alloc_process, public int_followFork, public int_signalMask, public int_LWPTracking, public int_memUsage
 {
  public:
@@ -137,6 +141,7 @@ class linux_process : public sysv_process, public unix_process, public thread_db
                              Dyninst::Address remote, size_t size);
    virtual bool plat_writeMem(int_thread *thr, const void *local,
                               Dyninst::Address remote, size_t size, bp_write_t bp_write);
+   virtual bool plat_readMemV(int_thread *thr, std::vector<mem_iov_t> &iovs);
    virtual SymbolReaderFactory *plat_defaultSymReader();
    virtual bool needIndividualThreadAttach();
    virtual bool getThreadLWPs(std::vector<Dyninst::LWP> &lwps);
@@ -162,6 +167,27 @@ class linux_process : public sysv_process, public unix_process, public thread_db
 
   protected:
    int computeAddrWidth();
+
+   //The /proc/<pid>/mem descriptor is opened on first use and kept until
+   // the address space it refers to goes away (exec, detach, terminate).
+   // Callers hold the returned reference across their pread/pwrite, so a
+   // concurrent closeMemFD only closes it once they are done with it.
+   std::shared_ptr<int> getMemFD();
+   void closeMemFD();
+  private:
+   std::shared_ptr<int> mem_fd;
+   Mutex<> mem_fd_lock;
+
+   //Set once process_vm_readv fails with EPERM, which a given target keeps
+   // returning (e.g. under a restrictive ptrace scope or a setuid target).
+   bool vm_readv_denied;
+
+   //The ptrace worker thread that traces this process.  A forked child
+   // shares its parent's, since the kernel makes the parent's tracer
+   // thread the child's tracer too.
+   LinuxPtrace *ptracer;
+  public:
+   LinuxPtrace *getPtracer();
 };
 
 class linux_x86_process : public linux_process, public x86_process
@@ -265,46 +291,104 @@ class linux_arm_thread : virtual public linux_thread, virtual public arm_thread
    virtual ~linux_arm_thread();
 };
 
+//Linux only lets the thread that attached to (or forked) a tracee make
+// ptrace calls on it, so all ptrace calls go through worker threads.  Each
+// traced process family gets its own worker, so operations on different
+// processes don't serialize on one thread.  A worker's thread is joined
+// when the last process of its family goes away; the object is kept and
+// restarted for a later process.  New LWPs and forked children are routed
+// to their creator's worker as soon as the event naming them is decoded.
+//
+//Requests live on the requesting thread's stack.  They are pushed onto
+// the worker's request list with a compare-and-swap, and the worker takes
+// the whole list at once, so several requests, or a batch from
+// ptrace_batch, are handled in one wakeup.
 class LinuxPtrace
 {
+public:
+   struct ptrace_op_t {
+      pt_req request;
+      void *addr;
+      void *data;
+      long ret;
+      int err;
+   };
 private:
    typedef enum {
       unknown,
       create_req,
       ptrace_req,
       ptrace_bulkread,
-      ptrace_bulkwrite
+      ptrace_bulkwrite,
+      exit_req
    } req_t;
 
-   req_t ptrace_request;
-   pt_req request;
-   pid_t pid;
-   void *addr;
-   void *data;
-   linux_process *proc;
-   Dyninst::Address remote_addr;
-   unsigned size;
-   long ret;
-   bool bret;
-   int err;
+   struct request_t {
+      req_t ptrace_request;
+      pt_req request;
+      pid_t pid;
+      void *addr;
+      void *data;
+      linux_process *proc;
+      Dyninst::Address remote_addr;
+      unsigned size;
+      long ret;
+      bool bret;
+      int err;
+      bool done;
+      request_t *next;
+   };
+
+   std::atomic<request_t *> requests;
+   std::atomic<bool> sleeping;
+   unsigned num_procs;
+
+   //Submitters currently using this worker.  A worker whose family has
+   // exited is stopped once it has none, and later submitters go to the
+   // shared worker instead.
+   std::atomic<unsigned> users;
+   std::atomic<bool> stopped;
+   bool exiting;
+   LinuxPtrace *use();
+   void unuse();
+   void stop();
 
    DThread thrd;
    CondVar<> init;
    CondVar<> cond;
-   CondVar<> ret_lock;
-   Mutex<> request_lock;
+   CondVar<> done_cond;
+
+   void submit(request_t *first, request_t *last);
+   void waitfor(request_t *req);
+   void handle(request_t *req);
 
-   void start_request();
-   void waitfor_ret();
-   void end_request();
    static LinuxPtrace *linuxptrace;
+   static Mutex<> workers_lock;
+   static std::vector<LinuxPtrace *> idle_workers;
+   static std::map<pid_t, LinuxPtrace *> workers_by_pid;
 public:
+   //The shared worker for pids that don't belong to a known process
    static LinuxPtrace *getPtracer();
+   //The worker tracing pid (a process or one of its LWPs)
+   static LinuxPtrace *getPtracer(pid_t pid);
+   //Route a new process or LWP to the worker tracing its creator
+   static void registerChild(pid_t parent, pid_t child);
+
+   //Take a worker for a new process family, and give it back
+   static LinuxPtrace *acquire();
+   void retain();
+   void release();
+
+   //Route ptrace calls on pid to this worker
+   void registerPid(pid_t pid);
+   void unregisterPid(pid_t pid);
+
    LinuxPtrace();
    ~LinuxPtrace();
    void start();
    void main();
    long ptrace_int(pt_req request_, pid_t pid_, void *addr_, void *data_);
+   void ptrace_batch(pid_t pid_, std::vector<ptrace_op_t> &ops);
    bool ptrace_read(Dyninst::Address inTrace, unsigned size_, void *inSelf, int pid_);
    bool ptrace_write(Dyninst::Address inTrace, unsigned size_, const void *inSelf, int pid_);
 
@@ -69,6 +69,7 @@ class FrameStepper;
 class StepperGroup;
 class CallTree;
 class int_walkerSet;
+struct frame_cache_t;
 
 class SW_EXPORT Walker {
  private:
@@ -159,13 +160,36 @@ class SW_EXPORT Walker {
    //Add frame steppers to the group
    bool addStepper(FrameStepper *stepper);
 
+   //Remember each thread's last stackwalk.  Once a later walk of the
+   // thread steps to a frame with the same SP, FP and RA as a frame in
+   // the last walk, the rest of the last walk is reused rather than
+   // walked again.  This assumes the caller frames above a matching frame
+   // have not changed, which holds for repeated samples of a running
+   // thread but can be fooled if the stack above that frame is rewritten.
+   // Walks of exited threads are dropped when a new thread is cached.
+   // Off by default.
+   void setFrameCaching(bool enable);
+   bool getFrameCaching() const;
+
+   struct frame_cache_stats_t {
+      unsigned long walks;          // Walks of a thread with a cached walk
+      unsigned long hits;           // Walks that reused a cached suffix
+      unsigned long frames_walked;  // Frames found by stepping
+      unsigned long frames_reused;  // Frames copied from the cache
+   };
+   frame_cache_stats_t getFrameCacheStats() const;
+
    virtual ~Walker();
  private:
+   bool spliceCachedFrames(std::vector<Frame> &stackwalk);
+   void cacheFrames(const std::vector<Frame> &stackwalk);
+
    ProcessState *proc;
    SymbolLookup *lookup;
    bool creation_error;
    StepperGroup *group;
    unsigned call_count;
+   frame_cache_t *frame_cache;
    static SymbolReaderFactory *symrfact;
 };
 
@@ -82,6 +82,8 @@ class DebugStepperImpl : public FrameStepper, public Dyninst::ProcessReader {
  protected:
   gcframe_ret_t getCallerFrameArch(Address pc, const Frame &in, Frame &out, 
                                    DwarfDyninst::DwarfFrameParserPtr dinfo, bool isVsyscallPage);
+  gcframe_ret_t getCallerFrameCompact(Address pc, const Frame &in, Frame &out,
+                                      DwarfDyninst::DwarfFrameParserPtr dinfo);
   bool isFrameRegister(MachRegister reg);
   bool isStackRegister(MachRegister reg);
 };
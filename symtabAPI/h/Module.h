@@ -36,6 +36,7 @@
 #include "Statement.h"
 #include "Symbol.h"
 
+#include <atomic>
 #include <set>
 #include <stddef.h>
 #include <string>
@@ -149,7 +150,10 @@ namespace Dyninst { namespace SymtabAPI {
     //  Super secret private methods that aren't really private
     typeCollection *getModuleTypesPrivate();
 
-    void setModuleTypes(typeCollection *tc) { typeInfo_ = tc; }
+    // Published with release ordering, read with acquire by
+    // getModuleTypesPrivate, since lazy type parsing can attach a
+    // collection while other threads look types up.
+    void setModuleTypes(typeCollection *tc) { typeInfo_.store(tc, std::memory_order_release); }
 
     bool setLineInfo(Dyninst::SymtabAPI::LineInformation *lineInfo);
     void addRange(Dyninst::Address low, Dyninst::Address high);
@@ -161,7 +165,7 @@ namespace Dyninst { namespace SymtabAPI {
   private:
     bool objectLevelLineInfo;
     Dyninst::SymtabAPI::LineInformation *lineInfo_;
-    typeCollection *typeInfo_;
+    std::atomic<typeCollection *> typeInfo_;
 
     std::string fileName_; // full path to file
     std::string compDir_;
@@ -76,6 +76,20 @@ struct symtab_impl;
 
 typedef Dyninst::ProcessReader MemRegReader;
 
+/*
+ * One result of Symtab::symbolize. Pointers are NULL and 'line' is zero
+ * when the corresponding information was not found.
+ */
+struct SymbolizedAddress {
+   Offset addr;
+   Function *function;      // Outermost, non-inlined function containing addr
+   FunctionBase *inlined;   // Innermost function containing addr; follow
+                            // getInlinedParent() for the rest of the inline chain
+   Module *module;
+   unsigned file_index;     // Index into module->getStrings()
+   unsigned line;
+};
+
 class SYMTAB_EXPORT Symtab : public LookupInterface,
                public AnnotatableSparse
 {
@@ -90,6 +104,7 @@ class SYMTAB_EXPORT Symtab : public LookupInterface,
    friend class Aggregate;
    friend class relocationEntry;
    friend class Object;
+   friend class typeCollection;
 
    // Hide implementation details that are complex or add large dependencies
    const std::unique_ptr<symtab_impl> impl;
@@ -245,6 +260,13 @@ class SYMTAB_EXPORT Symtab : public LookupInterface,
                        Offset addressInRange);
    bool getSourceLines(std::vector<LineNoTuple> &lines,
                                      Offset addressInRange);
+
+   /***** Batch symbolization *****/
+   // Resolve function, inline chain, module and source line for each of
+   // 'addrs'. out[i] describes addrs[i]. The addresses are sorted and the
+   // function-range and line tables are swept once in address order, so
+   // this is much cheaper than per-address lookups for large batches.
+   bool symbolize(std::vector<Offset> const& addrs, std::vector<SymbolizedAddress> &out);
    void setTruncateLinePaths(bool value);
    bool getTruncateLinePaths();
    
@@ -289,6 +311,9 @@ class SYMTAB_EXPORT Symtab : public LookupInterface,
    }
 
    void parseTypesNow();
+   // Parse only the debug information units that can define a type named name,
+   // falling back to parseTypesNow when the name is not indexed.
+   void parseTypesFor(std::string const& name);
 
    /***** Local Variable Information *****/
    bool findLocalVariable(std::vector<localVar *>&vars, std::string name);
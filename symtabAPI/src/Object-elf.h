@@ -46,6 +46,7 @@
 #include <assert.h>
 #include <ostream>
 #include <map>
+#include <memory>
 #include <stddef.h>
 #include <unordered_map>
 #include <utility>
@@ -54,6 +55,7 @@
 #include "MappedFile.h"
 #include "IntervalTree.h"
 #include "Module.h"
+#include "concurrent.h"
 #include <elf.h>
 #include <libelf.h>
 #include <string>
@@ -83,6 +85,38 @@ class Symtab;
 class Region;
 class Object;
 class InlinedFunction;
+class FunctionBase;
+
+// DWARF units are identified by the offset of their unit DIE and the section
+// (or supplementary file) holding them.
+enum dwarf_unit_section { unit_in_info, unit_in_types, unit_in_sup };
+typedef std::pair<Dwarf_Off, dwarf_unit_section> dwarf_unit_key;
+typedef std::set<dwarf_unit_key> dwarf_unit_set;
+
+// Which units name each type, and which units import each partial unit.
+// Built once to parse types one unit at a time.
+struct dwarf_type_index {
+  std::unordered_map<std::string, std::vector<dwarf_unit_key> > units_by_name;
+  std::map<dwarf_unit_key, std::vector<dwarf_unit_key> > importers;
+  // The other units each unit refers to, through DW_FORM_ref_sig8 (type
+  // units) or DW_FORM_ref_addr (e.g. cross-unit references after LTO).
+  std::map<dwarf_unit_key, std::vector<dwarf_unit_key> > unit_refs;
+  // The unit DIEs DwarfWalker::parse visits, so a lazy pass need not walk
+  // every unit header again.
+  std::map<dwarf_unit_key, Dwarf_Die> unit_dies;
+};
+
+// Functions whose children (locals, parameters, inlines) have been parsed.
+typedef Dyninst::dyn_c_hash_map<FunctionBase *, bool> dwarf_parsed_funcs;
+
+// What earlier type passes over a binary have already done.  parsed_funcs is
+// handed to every walker, so a function reached from several units (e.g.
+// through a shared partial unit) has its children parsed only once.
+struct dwarf_parse_state {
+  dwarf_unit_set parsed_units;
+  std::shared_ptr<dwarf_parsed_funcs> parsed_funcs{std::make_shared<dwarf_parsed_funcs>()};
+  bool shared_units_primed{false};
+};
 
 class open_statement {
     public:
@@ -167,6 +201,9 @@ public:
   void getModuleLanguageInfo(dyn_hash_map<std::string, supportedLanguages> *mod_langs);
   void parseFileLineInfo();
   void parseTypeInfo();
+  // Parse only the units that can define a type called name.  Returns false if
+  // no unit names it, in which case the caller should parse everything.
+  bool parseTypeInfoFor(std::string const& name);
   void addModule(SymtabAPI::Module* m) override;
 
   bool needs_function_binding() const override { return (plt_addr_ > 0); }
@@ -492,6 +529,11 @@ private:
   dyn_mutex dsm_lock;
   std::vector<DbgAddrConversion_t> DebugSectionMap;
 
+  // Lazy type parsing state; callers serialize parseTypeInfo*.
+  dwarf_parse_state type_parse_state;
+  dwarf_type_index type_index;
+  bool type_index_built{false};
+
  public:  
   std::set<std::string> prereq_libs;
   std::vector<std::pair<long, long> > new_dynamic_entries;
@@ -206,6 +206,8 @@ class Object : public AObject
     SYMTAB_EXPORT const char *interpreter_name() const { return NULL; }
     SYMTAB_EXPORT dyn_hash_map <std::string, LineInformation> &getLineInfo();
     SYMTAB_EXPORT void parseTypeInfo();
+    // PDB type information is parsed as a whole.
+    SYMTAB_EXPORT bool parseTypeInfoFor(std::string const&) { return false; }
     SYMTAB_EXPORT virtual Dyninst::Architecture getArch() const;
     SYMTAB_EXPORT void    ParseGlobalSymbol(PSYMBOL_INFO pSymInfo);
     SYMTAB_EXPORT const std::vector<Offset> &getPossibleMains() const   { return possible_mains; }
@@ -217,7 +217,7 @@ public:
 
     } Error;
 
-    using ParsedFuncs = Dyninst::dyn_c_hash_map<FunctionBase *, bool>;
+    using ParsedFuncs = dwarf_parsed_funcs;
 
     DwarfWalker(Symtab *symtab, Dwarf* dbg, std::shared_ptr<ParsedFuncs> pf = nullptr);
 
@@ -250,6 +250,24 @@ public:
 
     bool parse();
 
+    // Parse every unit not yet in state.parsed_units, adding each to it.
+    bool parse(dwarf_parse_state &state);
+
+    // Parse the given indexed units that are not yet in state.parsed_units.
+    // Unlike a full parse, this leaves the final module's types unfixed.
+    bool parse(dwarf_parse_state &state, dwarf_type_index const& index,
+               dwarf_unit_set const& units);
+
+    // One-time scan recording which units name each type, for lazy parsing.
+    void indexTypeNames(dwarf_type_index &index);
+    // The parseable units that may define a type called name, together with
+    // the units they reach through DW_FORM_ref_sig8 or DW_FORM_ref_addr.
+    static void unitsDefining(dwarf_type_index const& index, std::string const& name,
+                              dwarf_unit_set &units);
+
+    // Serially warm libdw state for units shared through the supplementary file.
+    static void primeSharedUnits(Dwarf *alt, std::vector<Dwarf_Die> const& module_dies);
+
     // Takes current debug state as represented by dbg_;
     bool parseModule(Dwarf_Die is_info, Module *&fixUnknownMod);
 
@@ -423,6 +441,10 @@ private:
     // Map to connect DW_FORM_ref_sig8 to type IDs.
     dyn_c_hash_map<uint64_t, typeId_t> sig8_type_ids_;
 
+    void indexUnitTypeNames(Dwarf_Die die, dwarf_unit_key const& unit, dwarf_type_index &index);
+    void parseUnits(dwarf_parse_state &state, std::vector<Dwarf_Die> const& all_dies,
+                    std::vector<Dwarf_Die> const& parse_dies, Module *&fixUnknownMod);
+
     bool parseModuleSig8(bool is_info);
     void findAllSig8Types();
     bool findSig8Type(Dwarf_Sig8 * signature, boost::shared_ptr<Type>&type);
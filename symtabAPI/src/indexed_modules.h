@@ -31,9 +31,19 @@
 #ifndef SYMTAB_INDEXED_MODULES
 #define SYMTAB_INDEXED_MODULES
 
+#include "IBSTree.h"
 #include "Module.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
 #include <boost/container_hash/hash.hpp>
+#include <tbb/concurrent_unordered_map.h>
 #include <tbb/concurrent_unordered_set.h>
 
 namespace Dyninst { namespace SymtabAPI {
@@ -54,33 +64,197 @@ namespace Dyninst { namespace SymtabAPI {
         return m1->fileName() == m2->fileName() && m1->addr() == m2->addr();
       }
     };
+
+    // One entry of the flattened address index. 'max_high' is the largest
+    // 'high' of this entry and every entry before it, which bounds how far
+    // back a lookup has to look when ranges overlap.
+    struct flat_mod_range {
+      Offset low;
+      Offset high;
+      Offset max_high;
+      Module *mod;
+    };
+
+    // Orders ranges so that, of those containing an address, the preferred
+    // one is the greatest: the highest 'low', then the smallest 'high', with
+    // the Module pointer breaking exact ties.
+    inline bool range_before(Offset low1, Offset high1, Module *m1,
+                             Offset low2, Offset high2, Module *m2) {
+      if(low1 != low2) return low1 < low2;
+      if(high1 != high2) return high1 > high2;
+      return std::less<Module *>()(m1, m2);
+    }
+
+    struct flat_mod_ranges {
+      std::vector<flat_mod_range> ranges;   // sorted by low
+      std::vector<flat_mod_range> spanning; // ranges of the default module
+      unsigned long version;
+    };
   }
 
+  /*
+   * The set of Modules in a Symtab, indexed by name, by base offset, and by
+   * the address ranges each module covers.
+   *
+   * Ranges are recorded in an IBSTree as they are added. Once the set stops
+   * changing, lookups are answered from a sorted, flat copy of the ranges
+   * that is immutable once published, so readers take no locks. The copy is
+   * rebuilt lazily, and only after enough lookups have been made against a
+   * stale copy to pay for the rebuild; interleaving additions and lookups
+   * during parsing therefore stays O(log n) per operation.
+   */
   class indexed_modules {
     tbb::concurrent_unordered_set<Module *, detail::hash, detail::equal> index;
+    tbb::concurrent_unordered_multimap<std::string, Module *> by_name;
+    tbb::concurrent_unordered_multimap<Offset, Module *> by_offset;
+
+    IBSTree<ModRange> range_tree;
+
+    // Guards all_ranges and publication of flat_ranges
+    mutable std::mutex ranges_lock;
+    std::vector<ModRange *> all_ranges;
+    std::atomic<size_t> num_ranges{0UL};
+    std::atomic<unsigned long> ranges_version{0UL};
+    mutable std::shared_ptr<const detail::flat_mod_ranges> flat_ranges;
+    mutable std::atomic<unsigned long> stale_lookups{0UL};
+
+    std::shared_ptr<const detail::flat_mod_ranges> current_ranges(Module *default_module) const {
+      auto flat = std::atomic_load(&flat_ranges);
+      auto const version = ranges_version.load();
+      if(flat && flat->version == version) {
+        return flat;
+      }
+      if(++stale_lookups < num_ranges.load()) {
+        return nullptr;
+      }
+
+      std::lock_guard<std::mutex> l(ranges_lock);
+      flat = std::atomic_load(&flat_ranges);
+      if(flat && flat->version == ranges_version.load()) {
+        return flat;
+      }
+
+      auto fresh = std::make_shared<detail::flat_mod_ranges>();
+      fresh->version = ranges_version.load();
+      fresh->ranges.reserve(all_ranges.size());
+      for(auto *r : all_ranges) {
+        detail::flat_mod_range fr{r->low(), r->high(), r->high(), r->id()};
+        if(r->id() == default_module) {
+          fresh->spanning.push_back(fr);
+        } else {
+          fresh->ranges.push_back(fr);
+        }
+      }
+      std::sort(fresh->ranges.begin(), fresh->ranges.end(),
+                [](detail::flat_mod_range const& a, detail::flat_mod_range const& b) {
+                  return detail::range_before(a.low, a.high, a.mod, b.low, b.high, b.mod);
+                });
+      Offset max_high{0};
+      for(auto &r : fresh->ranges) {
+        max_high = std::max(max_high, r.high);
+        r.max_high = max_high;
+      }
+
+      std::shared_ptr<const detail::flat_mod_ranges> published = fresh;
+      std::atomic_store(&flat_ranges, published);
+      stale_lookups = 0UL;
+      return published;
+    }
 
   public:
-    void insert(Module *m) { index.insert(m); }
+    void insert(Module *m) {
+      if(index.insert(m).second) {
+        by_name.insert(std::make_pair(m->fileName(), m));
+        by_offset.insert(std::make_pair(m->addr(), m));
+      }
+    }
+
+    void insert(std::vector<ModRange *> const& ranges) {
+      if(ranges.empty()) {
+        return;
+      }
+      std::lock_guard<std::mutex> l(ranges_lock);
+      for(auto *r : ranges) {
+        range_tree.insert(r);
+        all_ranges.push_back(r);
+      }
+      num_ranges = all_ranges.size();
+      ++ranges_version;
+    }
 
     bool contains(Module *m) const { return index.count(m) != 0UL; }
 
     std::vector<Module *> find(std::string const& name) const {
       std::vector<Module *> mods;
-      std::copy_if(index.begin(), index.end(), std::back_inserter(mods),
-                   [&name](Module *m) { return m->fileName() == name; });
+      auto r = by_name.equal_range(name);
+      for(auto i = r.first; i != r.second; ++i) {
+        mods.push_back(i->second);
+      }
       return mods;
     }
 
     Module *find(Dyninst::Offset offset) const {
-      for (auto *m : index) {
-        if (m->addr() == offset)
-          return m;
+      auto i = by_offset.find(offset);
+      return (i != by_offset.end()) ? i->second : nullptr;
+    }
+
+    /* Find the module whose ranges contain 'offset'.
+
+       Because the default module covers the entire PC range of the
+       file, it is only returned if no other module contains 'offset'.
+
+       If the ranges of several modules contain 'offset', the innermost
+       one is returned, as ordered by detail::range_before; the flat copy
+       and the IBSTree fallback agree on this.
+    */
+    Module *find_containing(Offset offset, Module *default_module) const {
+      auto flat = current_ranges(default_module);
+      if(!flat) {
+        std::set<ModRange *> mods;
+        range_tree.find(offset, mods);
+        ModRange *best{nullptr};
+        Module *found{nullptr};
+        for(auto *mr : mods) {
+          if(mr->id() == default_module) {
+            found = mr->id();
+            continue;
+          }
+          if(!best || detail::range_before(best->low(), best->high(), best->id(),
+                                           mr->low(), mr->high(), mr->id())) {
+            best = mr;
+          }
+        }
+        return best ? best->id() : found;
+      }
+
+      auto const& ranges = flat->ranges;
+      auto it = std::upper_bound(ranges.begin(), ranges.end(), offset,
+                                 [](Offset off, detail::flat_mod_range const& r) {
+                                   return off < r.low;
+                                 });
+      while(it != ranges.begin()) {
+        --it;
+        if(it->max_high <= offset) {
+          break;
+        }
+        if(offset < it->high) {
+          return it->mod;
+        }
+      }
+      for(auto const& r : flat->spanning) {
+        if(r.low <= offset && offset < r.high) {
+          return r.mod;
+        }
       }
       return nullptr;
     }
 
+    void print_ranges() { range_tree.PrintPreorder(); }
+
     bool empty() const { return index.empty(); }
 
+    size_t size() const { return index.size(); }
+
     decltype(index)::iterator begin() { return index.begin(); }
 
     decltype(index)::iterator end() { return index.end(); }
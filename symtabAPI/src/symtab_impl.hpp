@@ -8,9 +8,14 @@
 #include "indexed_symbols.hpp"
 #include "indexed_modules.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace Dyninst { namespace SymtabAPI {
 
@@ -23,6 +28,17 @@ namespace Dyninst { namespace SymtabAPI {
     std::once_flag funcRangesAreParsed{};
     std::once_flag types_parsed{};
 
+    // Serializes whole-binary and per-name type parsing.
+    std::mutex types_lock{};
+    std::atomic<bool> all_types_parsed{false};
+
+    // Names whose defining units have been parsed lazily.
+    dyn_c_hash_map<std::string, bool> types_parsed_for{};
+
+    // The type collection of each module.  Unlike the process-wide
+    // typeCollection::fileToTypesMap, this survives other binaries' parses.
+    dyn_c_hash_map<Module *, typeCollection *> module_types{};
+
     // Since Functions are unique by address, we require this structure to
     // efficiently track them.
     dyn_c_hash_map<Offset, Function *> funcsByOffset{};
@@ -30,36 +46,161 @@ namespace Dyninst { namespace SymtabAPI {
     using VarsByOffsetMap = dyn_c_hash_map<Offset, std::vector<Variable *>>;
     VarsByOffsetMap varsByOffset{};
 
-    using ModRangeLookup = IBSTree<ModRange>;
-    ModRangeLookup mod_lookup_{};
-
     using FuncRangeLookup = IBSTree<FuncRange>;
     FuncRangeLookup func_lookup{};
 
-    Module* default_module{};
+    // A flattened, address-sorted copy of the ranges in func_lookup, used
+    // by Symtab::symbolize to sweep the function ranges in address order.
+    struct flat_func_range {
+      Offset low;
+      Offset high;
+      Offset max_high;  // Largest 'high' of this range and all before it
+      FunctionBase *func;
+      Function *outer;  // Non-inlined function at the root of func's inline chain
+      unsigned depth;   // Length of func's inline chain
+    };
+    struct flat_func_ranges {
+      std::vector<flat_func_range> ranges; // sorted by low
+      unsigned long version;
+    };
+
+    std::mutex func_ranges_lock{};
+    std::vector<FuncRange *> all_func_ranges{};
+    std::atomic<unsigned long> func_ranges_version{0UL};
+    std::shared_ptr<const flat_func_ranges> sorted_func_ranges{};
+
+    // The latest sorted_func_ranges, readable without func_ranges_lock.
+    // Superseded copies are kept in retired_func_ranges, since a reader
+    // may still be using one.
+    std::atomic<flat_func_ranges const*> current_func_ranges{nullptr};
+    std::vector<std::shared_ptr<const flat_func_ranges>> retired_func_ranges{};
+    size_t retired_func_range_entries{0UL};
+    std::atomic<unsigned long> stale_func_range_lookups{0UL};
+
+    void addFuncRange(FuncRange *r) {
+      func_lookup.insert(r);
+      std::lock_guard<std::mutex> l(func_ranges_lock);
+      all_func_ranges.push_back(r);
+      ++func_ranges_version;
+    }
 
-    Module* getContainingModule(Offset offset) const {
-      std::set<ModRange*> mods;
-      mod_lookup_.find(offset, mods);
+    // Returns the sorted function ranges if they are current, without
+    // locking. Otherwise returns nullptr and the caller should search
+    // func_lookup; once enough lookups have done that to pay for it, the
+    // sorted ranges are rebuilt. No more are built once the retired copies
+    // hold several times as many ranges as the current set.
+    flat_func_ranges const* findSortedFuncRanges() {
+      auto const *flat = current_func_ranges.load(std::memory_order_acquire);
+      if(flat && flat->version == func_ranges_version.load(std::memory_order_acquire)) {
+        return flat;
+      }
+      auto const stale = stale_func_range_lookups.fetch_add(1, std::memory_order_relaxed);
+      if(stale < 16 + (flat ? flat->ranges.size() : 0UL)) {
+        return nullptr;
+      }
+      {
+        std::lock_guard<std::mutex> l(func_ranges_lock);
+        if(retired_func_range_entries > 4 * all_func_ranges.size() + 4096) {
+          stale_func_range_lookups = 0;
+          return nullptr;
+        }
+      }
+      getSortedFuncRanges();
+      return nullptr;
+    }
 
-      if(mods.size() == 1) {
-	auto const& m = *(mods.begin());
-        return m->id();
+    std::shared_ptr<const flat_func_ranges> getSortedFuncRanges() {
+      std::lock_guard<std::mutex> l(func_ranges_lock);
+      if(sorted_func_ranges && sorted_func_ranges->version == func_ranges_version) {
+        return sorted_func_ranges;
       }
+      auto flat = std::make_shared<flat_func_ranges>();
+      flat->version = func_ranges_version;
+      flat->ranges.reserve(all_func_ranges.size());
+      for(auto *r : all_func_ranges) {
+        FunctionBase *root = r->container;
+        unsigned depth = 0;
+        for(FunctionBase *f = r->container; f; f = f->getInlinedParent()) {
+          root = f;
+          depth++;
+        }
+        flat->ranges.push_back({r->low(), r->high(), r->high(), r->container,
+                                dynamic_cast<Function *>(root), depth});
+      }
+      std::stable_sort(flat->ranges.begin(), flat->ranges.end(),
+                       [](flat_func_range const& a, flat_func_range const& b) {
+                         return a.low < b.low;
+                       });
+      Offset max_high{0};
+      for(auto &r : flat->ranges) {
+        max_high = std::max(max_high, r.high);
+        r.max_high = max_high;
+      }
+      if(sorted_func_ranges) {
+        retired_func_range_entries += sorted_func_ranges->ranges.size();
+        retired_func_ranges.push_back(std::move(sorted_func_ranges));
+      }
+      sorted_func_ranges = flat;
+      current_func_ranges.store(flat.get(), std::memory_order_release);
+      stale_func_range_lookups = 0;
+      return sorted_func_ranges;
+    }
+
+    Module* default_module{};
 
-      /* Because the default module covers the entire PC range of the
-         file, it will always be found so exclude it.
+    // Maps the file name (without directories) of each source file named in
+    // a module's string table to the modules that name it, so line-to-address
+    // queries only visit modules that can contain the file. The key is the
+    // base name because LineInformation::range matches on that, so a query
+    // for "dir/foo.c" must find modules that only recorded "foo.c".
+    //
+    // String tables only grow when a module is added or its line information
+    // is parsed; both bump 'source_generation', and the index is rebuilt only
+    // when the generation it was built at is out of date.
+    using SourceIndex = std::unordered_map<std::string, std::vector<Module *>>;
+    std::atomic<unsigned long> source_generation{0UL};
+    std::mutex source_index_lock{};
+    std::shared_ptr<const SourceIndex> source_index{};
+    std::atomic<unsigned long> source_index_generation{~0UL};
+
+    void sourcesChanged() {
+      source_generation.fetch_add(1, std::memory_order_release);
+    }
 
-         It is assumed that the PC ranges of modules are disjoint and this
-         function can only return a single Module.
-      */
-      for(auto *mr : mods) {
-        if(mr->id() != default_module) {
-          return mr->id();
-	}
+    std::shared_ptr<const SourceIndex> getSourceIndex() {
+      auto const gen = source_generation.load(std::memory_order_acquire);
+      if(source_index_generation.load(std::memory_order_acquire) == gen) {
+        return std::atomic_load(&source_index);
+      }
+      std::lock_guard<std::mutex> l(source_index_lock);
+      auto const cur = source_generation.load(std::memory_order_acquire);
+      if(source_index && source_index_generation.load(std::memory_order_relaxed) == cur) {
+        return source_index;
+      }
+      auto idx = std::make_shared<SourceIndex>();
+      for(auto i = modules.cbegin(); i != modules.cend(); ++i) {
+        Module *m = *i;
+        StringTablePtr strings = m->getStrings();
+        if(!strings) {
+          continue;
+        }
+        boost::unique_lock<dyn_mutex> sl(strings->lock);
+        for(auto const& e : *strings) {
+          auto &mods = (*idx)[e.filename];
+          if(mods.empty() || mods.back() != m) {
+            mods.push_back(m);
+          }
+        }
       }
+      std::atomic_store(&source_index, std::shared_ptr<const SourceIndex>(idx));
+      // A bump that raced with the scan leaves this behind 'source_generation',
+      // so the next query rebuilds.
+      source_index_generation.store(cur, std::memory_order_release);
+      return idx;
+    }
 
-      return nullptr;
+    Module* getContainingModule(Offset offset) const {
+      return modules.find_containing(offset, default_module);
     }
   };
 